@@ -15,6 +15,49 @@ bool Polygon::is_reflex(size_t i) const {
     return cross_product_z(prev, curr, next) < -EPSILON;
 }
 
+PolygonEdit Polygon::insert_vertex(const size_t i, const Point p) {
+    const size_t n = vertices.size();
+    const Point prev = get_vertex(i + n - 1), next = get_vertex(i);
+    vertices.insert(vertices.begin() + static_cast<std::ptrdiff_t>(i), p);
+    ++revision;
+
+    return {PolygonEdit::Kind::Insert, i, cross_product_z(prev, p, next), {{prev, p, next}}};
+}
+
+PolygonEdit Polygon::remove_vertex(const size_t i) {
+    const size_t n = vertices.size();
+    const Point prev = get_vertex(i + n - 1), curr = get_vertex(i), next = get_vertex(i + 1);
+    vertices.erase(vertices.begin() + static_cast<std::ptrdiff_t>(i));
+    ++revision;
+
+    return {PolygonEdit::Kind::Remove, i, -cross_product_z(prev, curr, next), {{prev, curr, next}}};
+}
+
+PolygonEdit Polygon::move_vertex(const size_t i, const Point p) {
+    const size_t n = vertices.size();
+    const Point prev = get_vertex(i + n - 1), old = get_vertex(i), next = get_vertex(i + 1);
+    vertices[i] = p;
+    ++revision;
+
+    // The region between prev->old->next and prev->p->next, split along old-p.
+    return {PolygonEdit::Kind::Move, i, cross_product_z(prev, p, next) - cross_product_z(prev, old, next),
+            {{prev, old, p}, {old, next, p}}};
+}
+
+bool PolygonEdit::touches(const Segment& s) const {
+    for (const auto& [a, b, c] : swept) {
+        if (segments_intersect(s, {a, b}) || segments_intersect(s, {b, c}) || segments_intersect(s, {c, a}))
+            return true;
+
+        // Segment strictly inside the triangle
+        const double d1 = cross_product_z(a, b, s.p1), d2 = cross_product_z(b, c, s.p1),
+            d3 = cross_product_z(c, a, s.p1);
+        if ((d1 > EPSILON && d2 > EPSILON && d3 > EPSILON) || (d1 < -EPSILON && d2 < -EPSILON && d3 < -EPSILON))
+            return true;
+    }
+    return false;
+}
+
 double dist_sq(const Point a, const Point b) {
     const double dx = a.x - b.x, dy = a.y - b.y;
     return dx * dx + dy * dy;
@@ -57,7 +100,7 @@ bool is_point_in_polygon(const Polygon& P, const Point& p) {
             if (p.x < ((v2.x - v1.x) * (p.y - v1.y) / (v2.y - v1.y) + v1.x))
                 inside = !inside;
         }
-        if (on_segment(p, {v1, v2}))
+        if (orientation(v1, v2, p) == 0 && on_segment(p, {v1, v2}))
             return true; // Boundary inclusion
     }
     return inside;
@@ -79,7 +122,8 @@ bool is_visible_naive(const Polygon& P, Point q, Point r) {
             if ((q == edge.p1 || q == edge.p2 || r == edge.p1 || r == edge.p2))
                 continue;
             // Grazing boundary lines (collinear overlap with edge) -> treated as visible if strictly on it
-            if (on_segment(edge.p1, query_seg) || on_segment(edge.p2, query_seg))
+            if ((orientation(q, r, edge.p1) == 0 && on_segment(edge.p1, query_seg)) ||
+                (orientation(q, r, edge.p2) == 0 && on_segment(edge.p2, query_seg)))
                 continue;
 
             const int o1 = orientation(query_seg.p1, query_seg.p2, edge.p1),
@@ -1,6 +1,7 @@
 #ifndef TV_GEOMETRY_H
 #define TV_GEOMETRY_H
 
+#include <array>
 #include <vector>
 #include <cmath>
 #include <iostream>
@@ -30,11 +31,29 @@ struct Segment {
     Point p2;
 };
 
+// Describes one localized edit of a Polygon, so that dependent structures
+// can update in time proportional to the edit instead of rebuilding.
+struct PolygonEdit {
+    enum class Kind { Insert, Remove, Move };
+
+    Kind kind;
+    size_t vertex;      // Edited index (for Insert: index of the new vertex)
+    double area_delta;  // Change in twice the signed area of P
+
+    // Triangles covering every point that entered or left P.
+    std::vector<std::array<Point, 3>> swept;
+
+    // True if s touches any region swept by the edit.
+    bool touches(const Segment& s) const;
+};
+
 struct Polygon {
     std::vector<Point> vertices;
+    size_t revision = 0; // Bumped by every edit below, so derived structures can detect they are stale
 
     void add_vertex(double x, double y) {
         vertices.push_back({x, y});
+        ++revision;
     }
 
     size_t size() const {
@@ -48,6 +67,12 @@ struct Polygon {
 
     Segment get_edge(const size_t &i) const;
     bool is_reflex(size_t i) const;
+
+    // Localized edits: O(1) geometry work, besides shifting the vertex storage.
+    // The caller keeps P simple; remove_vertex requires more than 3 vertices.
+    PolygonEdit insert_vertex(size_t i, Point p); // p becomes vertex i, before the old vertex i
+    PolygonEdit remove_vertex(size_t i);
+    PolygonEdit move_vertex(size_t i, Point p);
 };
 
 // --- Primitives ---
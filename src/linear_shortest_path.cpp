@@ -7,15 +7,48 @@
 // Bring in visibility check
 #include "geometry.h"
 
-LinearShortestPath::LinearShortestPath(const Polygon& poly) : P(poly) {
-    double area = 0.0;
+LinearShortestPath::LinearShortestPath(const Polygon& poly) : P(poly), twice_area(0.0) {
     const size_t n = P.size();
     const Point origin{0,0};
 
+    reflex.resize(n);
     for(size_t i=0; i<n; ++i) {
-        area += cross_product_z(origin, P.get_vertex(i), P.get_vertex(i+1));
+        twice_area += cross_product_z(origin, P.get_vertex(i), P.get_vertex(i+1));
+    }
+    ccw_winding = (twice_area > EPSILON);
+
+    for(size_t i=0; i<n; ++i) {
+        reflex[i] = is_reflex(i);
+    }
+}
+
+bool LinearShortestPath::is_reflex(size_t i) const {
+    // Polygon::is_reflex assumes CCW; a CW polygon turns inward to the left instead.
+    if (ccw_winding) return P.is_reflex(i);
+    const size_t n = P.size();
+    return cross_product_z(P.get_vertex(i + n - 1), P.get_vertex(i), P.get_vertex(i + 1)) > EPSILON;
+}
+
+void LinearShortestPath::apply(const PolygonEdit& edit) {
+    const bool was_ccw = ccw_winding;
+    twice_area += edit.area_delta;
+    ccw_winding = (twice_area > EPSILON);
+
+    const auto at = reflex.begin() + static_cast<ptrdiff_t>(edit.vertex);
+    if (edit.kind == PolygonEdit::Kind::Insert) reflex.insert(at, false);
+    if (edit.kind == PolygonEdit::Kind::Remove) reflex.erase(at);
+
+    const size_t n = P.size();
+    if (ccw_winding != was_ccw) {
+        // Inside and outside swapped: every vertex changes side.
+        for (size_t i = 0; i < n; ++i) reflex[i] = is_reflex(i);
+        return;
+    }
+
+    // Turn direction depends on the two adjacent edges only.
+    for (size_t i = edit.vertex + n - 1; i <= edit.vertex + n + 1; ++i) {
+        reflex[i % n] = is_reflex(i % n);
     }
-    ccw_winding = (area > EPSILON);
 }
 
 // Logic: > 0 for Left Turn, < 0 for Right Turn.
@@ -39,8 +72,11 @@ std::vector<Point> LinearShortestPath::compute(Point start, Point end) const {
     pivots.reserve(P.size() + 2);
     pivots.push_back(start);
 
-    for(size_t i=0; i<P.size(); ++i) {
-        if (P.is_reflex(i)) {
+    // Walked in CCW order whatever the winding of P.
+    const size_t n = P.size();
+    for(size_t k=0; k<n; ++k) {
+        const size_t i = ccw_winding ? k : n - 1 - k;
+        if (reflex[i]) {
             Point v = P.get_vertex(i);
             if (v != start && v != end) {
                 pivots.push_back(v);
@@ -9,11 +9,20 @@ using namespace std;
 // exclusively on Polygon Reflex Vertices (Geometric constraints).
 class LinearShortestPath {
     const Polygon& P;
+    double twice_area;
     bool ccw_winding;
+    vector<bool> reflex; // is_reflex, precomputed per vertex
+
+    // Reflex with respect to the interior of P, for either winding.
+    bool is_reflex(size_t i) const;
 
 public:
     explicit LinearShortestPath(const Polygon& poly);
 
+    // Brings the precomputed state in line with an edit already made to P.
+    // Only the edited vertex and its two neighbours are re-evaluated.
+    void apply(const PolygonEdit& edit);
+
     // Computes topological shortest path pivot points strictly O(N).
     vector<Point> compute(Point start, Point end) const;
 };
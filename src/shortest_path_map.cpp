@@ -0,0 +1,277 @@
+#include "shortest_path_map.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+ShortestPathMap::ShortestPathMap(const Polygon& poly, const Point source)
+    : P(poly), origin(source)
+{
+    rebuild();
+}
+
+void ShortestPathMap::rebuild() {
+    triangulate();
+    build_shortest_path_tree();
+    build_slab_decomposition();
+    built_revision = P.revision;
+}
+
+void ShortestPathMap::triangulate() {
+    nodes.clear();
+    triangles.clear();
+    nodes.push_back({origin, NO_PARENT});
+
+    const size_t n = P.size();
+    double twice_area = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        nodes.push_back({P.get_vertex(i), NO_PARENT});
+        twice_area += cross_product_z({0, 0}, P.get_vertex(i), P.get_vertex(i + 1));
+    }
+    if (n < 3) return;
+
+    // Ring of tree nodes in CCW order, as a doubly linked list over ring positions.
+    std::vector<size_t> ring(n), prev(n), next(n);
+    for (size_t k = 0; k < n; ++k) {
+        ring[k] = 1 + (twice_area > 0 ? k : n - 1 - k);
+        prev[k] = (k + n - 1) % n;
+        next[k] = (k + 1) % n;
+    }
+
+    const auto site = [&](const size_t k) { return nodes[ring[k]].site; };
+    const auto is_convex = [&](const size_t k) {
+        return cross_product_z(site(prev[k]), site(k), site(next[k])) > EPSILON;
+    };
+
+    // An ear is a convex corner whose triangle holds no reflex vertex of the remaining ring.
+    const auto is_ear = [&](const size_t k) {
+        if (!is_convex(k)) return false;
+        const Point a = site(prev[k]), b = site(k), c = site(next[k]);
+
+        for (size_t q = next[next[k]]; q != prev[k]; q = next[q]) {
+            const Point v = site(q);
+            if (is_convex(q) || v == a || v == b || v == c) continue;
+            if (cross_product_z(a, b, v) >= -EPSILON && cross_product_z(b, c, v) >= -EPSILON &&
+                cross_product_z(c, a, v) >= -EPSILON)
+                return false;
+        }
+        return true;
+    };
+
+    // Ear clipping: O(n) per ear test, typically O(n) tests in total.
+    size_t k = 0, remaining = n, misses = 0;
+    while (remaining > 3) {
+        // Round-off can leave no strict ear; clip anyway rather than loop forever.
+        if (is_ear(k) || misses > remaining) {
+            triangles.push_back({{ring[prev[k]], ring[k], ring[next[k]]}, {}, 0});
+            next[prev[k]] = next[k];
+            prev[next[k]] = prev[k];
+            k = prev[k];
+            --remaining;
+            misses = 0;
+        } else {
+            k = next[k];
+            ++misses;
+        }
+    }
+    triangles.push_back({{ring[prev[k]], ring[k], ring[next[k]]}, {}, 0});
+}
+
+size_t ShortestPathMap::wedge_of(const std::vector<size_t>& funnel, const size_t apex, const Point& p) const {
+    // The line through funnel[i] and funnel[i + 1] separates wedge i from wedge i + 1.
+    // Along the chain from the first endpoint to the apex p is beyond it when on its left,
+    // along the chain from the apex to the last endpoint when on its right.
+    size_t lo = 0, hi = funnel.size() - 1;
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        const double turn = cross_product_z(nodes[funnel[mid]].site, nodes[funnel[mid + 1]].site, p);
+        if (mid < apex ? turn > 0 : turn < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+void ShortestPathMap::build_shortest_path_tree() {
+    // Dual tree: the triangles on each side of every triangle edge.
+    std::map<std::pair<size_t, size_t>, std::vector<size_t>> sides;
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        const auto& c = triangles[t].corners;
+        for (size_t e = 0; e < 3; ++e)
+            sides[std::minmax(c[e], c[(e + 1) % 3])].push_back(t);
+    }
+
+    const auto contains = [&](const Triangle& t, const Point& p) {
+        const Point a = nodes[t.corners[0]].site, b = nodes[t.corners[1]].site, c = nodes[t.corners[2]].site;
+        return cross_product_z(a, b, p) >= -EPSILON && cross_product_z(b, c, p) >= -EPSILON &&
+               cross_product_z(c, a, p) >= -EPSILON;
+    };
+    const auto root = std::ranges::find_if(triangles, [&](const Triangle& t) { return contains(t, origin); });
+    if (root == triangles.end()) return;
+
+    // Work item: a triangle entered across (u, v), its third corner left of u->v.
+    struct Entry {
+        size_t triangle;
+        size_t u;
+        size_t v;
+        std::vector<size_t> funnel;
+        size_t apex;
+    };
+    std::vector<Entry> stack;
+
+    const auto enqueue_neighbour = [&](const size_t from, const size_t u, const size_t v,
+                                       std::vector<size_t> funnel, const size_t apex) {
+        for (const size_t t : sides[std::minmax(u, v)]) {
+            if (t != from)
+                stack.push_back({t, u, v, std::move(funnel), apex});
+        }
+    };
+
+    // The source sees its whole triangle.
+    const size_t r = static_cast<size_t>(std::distance(triangles.begin(), root));
+    root->funnel = {0};
+    root->apex = 0;
+    for (const size_t c : root->corners)
+        nodes[c].parent = 0;
+    for (size_t e = 0; e < 3; ++e) {
+        const size_t a = root->corners[e], b = root->corners[(e + 1) % 3];
+        if (nodes[a].site == origin) enqueue_neighbour(r, b, a, {b, a}, 1);
+        else if (nodes[b].site == origin) enqueue_neighbour(r, b, a, {b, a}, 0);
+        else enqueue_neighbour(r, b, a, {b, 0, a}, 1);
+    }
+
+    // Funnel sweep over the dual tree: each triangle's third corner hangs off the
+    // funnel node whose wedge holds it, which splits the funnel in two.
+    while (!stack.empty()) {
+        Entry entry = std::move(stack.back());
+        stack.pop_back();
+
+        Triangle& tri = triangles[entry.triangle];
+        const auto& c = tri.corners;
+        const size_t w = c[0] != entry.u && c[0] != entry.v ? c[0] : c[1] != entry.u && c[1] != entry.v ? c[1] : c[2];
+
+        const std::vector<size_t>& funnel = entry.funnel;
+        const size_t j = wedge_of(funnel, entry.apex, nodes[w].site);
+        const size_t pivot = funnel[j];
+        nodes[w].parent = pivot;
+
+        std::vector<size_t> toward_u(funnel.begin(), funnel.begin() + static_cast<std::ptrdiff_t>(j) + 1);
+        toward_u.push_back(w);
+        std::vector<size_t> toward_v{w};
+        toward_v.insert(toward_v.end(), funnel.begin() + static_cast<std::ptrdiff_t>(j), funnel.end());
+
+        enqueue_neighbour(entry.triangle, entry.u, w, std::move(toward_u), std::min(entry.apex, j));
+        enqueue_neighbour(entry.triangle, w, entry.v, std::move(toward_v), std::max(entry.apex, j) - j + 1);
+
+        tri.funnel = std::move(entry.funnel);
+        tri.apex = entry.apex;
+    }
+}
+
+double ShortestPathMap::segment_y_at(const size_t segment, const double x) const {
+    const auto& [a, b, above] = segments[segment];
+    return a.y + (x - a.x) * (b.y - a.y) / (b.x - a.x);
+}
+
+void ShortestPathMap::build_slab_decomposition() {
+    segments.clear();
+    slab_bounds.clear();
+    slabs.clear();
+
+    // Every interior edge is the floor of exactly one triangle; boundary edges
+    // with P below them are stored as floors of the outside.
+    std::map<std::pair<size_t, size_t>, size_t> edge_uses;
+    for (const Triangle& t : triangles) {
+        for (size_t e = 0; e < 3; ++e)
+            ++edge_uses[std::minmax(t.corners[e], t.corners[(e + 1) % 3])];
+    }
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        const auto& c = triangles[t].corners;
+        for (size_t e = 0; e < 3; ++e) {
+            const Point a = nodes[c[e]].site, b = nodes[c[(e + 1) % 3]].site;
+            if (a.x < b.x - EPSILON)
+                segments.push_back({a, b, t});
+            else if (a.x > b.x + EPSILON && edge_uses[std::minmax(c[e], c[(e + 1) % 3])] == 1)
+                segments.push_back({b, a, OUTSIDE});
+        }
+    }
+
+    for (const Point& v : P.vertices)
+        slab_bounds.push_back(v.x);
+    std::ranges::sort(slab_bounds);
+    const auto last = std::ranges::unique(slab_bounds, [](double a, double b){ return std::abs(a - b) < EPSILON; }).begin();
+    slab_bounds.erase(last, slab_bounds.end());
+
+    if (slab_bounds.size() < 2) return;
+    slabs.resize(slab_bounds.size() - 1);
+
+    for (size_t j = 0; j < slabs.size(); ++j) {
+        const double mid = (slab_bounds[j] + slab_bounds[j + 1]) / 2.0;
+        Slab& slab = slabs[j];
+
+        for (size_t s = 0; s < segments.size(); ++s) {
+            if (segments[s].a.x < mid && segments[s].b.x > mid)
+                slab.segments.push_back(s);
+        }
+        // Triangle edges do not cross inside a slab, so the order at mid holds throughout.
+        std::ranges::sort(slab.segments, [&](size_t a, size_t b) { return segment_y_at(a, mid) < segment_y_at(b, mid); });
+    }
+}
+
+std::optional<size_t> ShortestPathMap::locate_in_slab(const size_t j, const Point& p) const {
+    const Slab& slab = slabs[j];
+
+    // Highest floor below p by binary search on the sorted segments O(log n)
+    const double x = std::clamp(p.x, slab_bounds[j], slab_bounds[j + 1]);
+    const auto below = std::ranges::partition_point(slab.segments, [&](size_t s) { return segment_y_at(s, x) < p.y - EPSILON; });
+    const size_t k = std::distance(slab.segments.begin(), below);
+
+    // Points on a segment belong to the triangle above it, or below it on the top boundary.
+    if (k < slab.segments.size() && std::abs(segment_y_at(slab.segments[k], x) - p.y) < EPSILON &&
+        segments[slab.segments[k]].above != OUTSIDE)
+        return segments[slab.segments[k]].above;
+    if (k == 0 || segments[slab.segments[k - 1]].above == OUTSIDE)
+        return std::nullopt;
+    return segments[slab.segments[k - 1]].above;
+}
+
+std::optional<size_t> ShortestPathMap::locate(const Point& p) const {
+    if (slabs.empty() || p.x < slab_bounds.front() - EPSILON || p.x > slab_bounds.back() + EPSILON)
+        return std::nullopt;
+
+    // Slab by binary search on x O(log n)
+    const auto it = std::ranges::upper_bound(slab_bounds, p.x);
+    const size_t j = std::clamp<size_t>(std::distance(slab_bounds.begin(), it), 1, slabs.size()) - 1;
+    if (const auto cell = locate_in_slab(j, p)) return cell;
+
+    // On a slab boundary, e.g. a vertical edge with P to its left, the slab on the other side holds p.
+    if (j > 0 && std::abs(p.x - slab_bounds[j]) < EPSILON) return locate_in_slab(j - 1, p);
+    if (j + 1 < slabs.size() && std::abs(p.x - slab_bounds[j + 1]) < EPSILON) return locate_in_slab(j + 1, p);
+    return std::nullopt;
+}
+
+std::vector<Point> ShortestPathMap::compute(const Point target) const {
+    if (is_stale()) throw std::logic_error("ShortestPathMap::compute: P was edited since the map was built");
+    if (target == origin) return {origin};
+
+    const auto cell = locate(target);
+    if (!cell || triangles[*cell].funnel.empty()) return {};
+
+    // A target on a corner of its triangle hangs off that corner's own tree node;
+    // the wedge search could otherwise pick a node further down the funnel.
+    const Triangle& tri = triangles[*cell];
+    const auto corner = std::ranges::find_if(tri.corners, [&](size_t c) { return nodes[c].site == target; });
+    const size_t pivot = corner != tri.corners.end() ? *corner : tri.funnel[wedge_of(tri.funnel, tri.apex, target)];
+
+    std::vector<Point> path{target};
+    for (size_t u = pivot; u != NO_PARENT; u = nodes[u].parent)
+        path.push_back(nodes[u].site);
+    std::ranges::reverse(path);
+
+    // A target or source sitting on a vertex is its own pivot.
+    const auto last = std::ranges::unique(path).begin();
+    path.erase(last, path.end());
+    return path;
+}
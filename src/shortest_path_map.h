@@ -0,0 +1,93 @@
+#ifndef TV_SHORTEST_PATH_MAP_H
+#define TV_SHORTEST_PATH_MAP_H
+
+#include "geometry.h"
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <vector>
+
+// Shortest Path Map (SPM) of P with respect to a fixed source point.
+// Built once, it answers the geodesic pivots from the source to any
+// target inside P without re-running the per-pair path computation.
+//
+// Construction: ear-clipping triangulation of P, then a funnel sweep over
+//               its dual tree giving the shortest path tree of all vertices
+//               and, per triangle, the fan of last-pivot wedges entering it.
+//               Triangle edges are indexed by a vertical slab decomposition.
+// Query: O(log n) point location of the target's triangle, O(log n) search
+//        of its wedge fan for the last pivot, then a walk up the parent
+//        pointers of the tree.
+// The tree spans all of P, so any PolygonEdit invalidates the whole map:
+// the map records P.revision and throws on queries until rebuilt.
+class ShortestPathMap {
+    static constexpr size_t NO_PARENT = std::numeric_limits<size_t>::max();
+    static constexpr size_t OUTSIDE = std::numeric_limits<size_t>::max();
+
+    // A vertex of the shortest path tree: the source (index 0) or vertex i of P (index 1 + i).
+    struct TreeNode {
+        Point site;
+        size_t parent;
+    };
+
+    // Triangle of the triangulation, with the funnel through which the source reaches it.
+    // The lines through consecutive funnel nodes split the triangle into wedges,
+    // and every point of wedge k has funnel[k] as its last pivot.
+    struct Triangle {
+        std::array<size_t, 3> corners; // Tree nodes, CCW
+        std::vector<size_t> funnel;    // Empty if the source does not reach the triangle
+        size_t apex;                   // Index of the funnel's apex in funnel
+    };
+
+    // Non-vertical triangle edge with a.x < b.x, tagged with the triangle above it.
+    struct FloorSegment {
+        Point a;
+        Point b;
+        size_t above; // Triangle index or OUTSIDE
+    };
+
+    // Segments crossing the open x-range between two consecutive vertex abscissae, sorted bottom to top.
+    struct Slab {
+        std::vector<size_t> segments;
+    };
+
+    const Polygon& P;
+    Point origin;
+    size_t built_revision;
+
+    std::vector<TreeNode> nodes;
+    std::vector<Triangle> triangles;
+    std::vector<FloorSegment> segments;
+    std::vector<double> slab_bounds;
+    std::vector<Slab> slabs;
+
+    void triangulate();
+    void build_shortest_path_tree();
+    void build_slab_decomposition();
+
+    double segment_y_at(size_t segment, double x) const;
+    std::optional<size_t> locate_in_slab(size_t slab, const Point& p) const;
+    std::optional<size_t> locate(const Point& p) const;
+    size_t wedge_of(const std::vector<size_t>& funnel, size_t apex, const Point& p) const;
+
+public:
+    ShortestPathMap(const Polygon& poly, Point source);
+
+    const Point& source() const { return origin; }
+
+    // True if P was edited since the map was built.
+    bool is_stale() const { return built_revision != P.revision; }
+
+    // Rebuilds the whole map against the current P.
+    void rebuild();
+
+    // Shortest path pivots from the source to target, endpoints included.
+    // Same contract as LinearShortestPath::compute(source(), target).
+    // Returns an empty path if target is not reachable inside P.
+    // Throws std::logic_error if the map is stale, so that a query against an
+    // edited P cannot be mistaken for an unreachable target.
+    std::vector<Point> compute(Point target) const;
+};
+
+#endif // TV_SHORTEST_PATH_MAP_H
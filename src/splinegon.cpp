@@ -7,18 +7,32 @@
 SplinegonDiagram::SplinegonDiagram(const Polygon& poly, const Trajectory& q, const Trajectory& r)
     : P(poly), q_geom(q), r_geom(r) 
 {
-    construct_monotone_decomposition();
-}
-
-void SplinegonDiagram::construct_monotone_decomposition() {
-    lower_envelope_sectors.clear();
-
     // STEP 1: PREPROCESSING (Strict Linear Time O(N))
     // Compute the 'Taut String' (Geodesic) between trajectory origins.
     // The vertices of this path are the Critical Constraints (Reflex vertices/Bi-tangents).
-    
     LinearShortestPath O_N_solver(P);
-    auto pivots = O_N_solver.compute(q_geom.start, r_geom.start);
+    construct_monotone_decomposition(O_N_solver.compute(q_geom.start, r_geom.start));
+}
+
+SplinegonDiagram::SplinegonDiagram(const Polygon& poly, const ShortestPathMap& spm, const Trajectory& q, const Trajectory& r)
+    : P(poly), q_geom(q), r_geom(r)
+{
+    // STEP 1 (amortized): the geodesic from q.start is read off the precomputed map.
+    if (spm.source() == q_geom.start && !spm.is_stale()) {
+        // An empty path would leave no sectors, which shoot_ray reads as "visible at t=0".
+        const std::vector<Point> pivots = spm.compute(r_geom.start);
+        if (!pivots.empty()) {
+            construct_monotone_decomposition(pivots);
+            return;
+        }
+    }
+    LinearShortestPath O_N_solver(P);
+    construct_monotone_decomposition(O_N_solver.compute(q_geom.start, r_geom.start));
+}
+
+void SplinegonDiagram::construct_monotone_decomposition(const std::vector<Point>& pivots) {
+    lower_envelope_sectors.clear();
+    geodesic = pivots;
 
     // STEP 2: BUILD ANGULAR ARRANGEMENT
     // Map each critical reflex vertex to its angular sector in Diagram D.
@@ -51,6 +65,21 @@ void SplinegonDiagram::construct_monotone_decomposition() {
     }
 }
 
+bool SplinegonDiagram::is_affected_by(const PolygonEdit& edit) const {
+    if (geodesic.empty()) return true;
+    if (geodesic.size() == 1) return edit.touches({geodesic[0], geodesic[0]});
+
+    for (size_t i = 0; i + 1 < geodesic.size(); ++i) {
+        if (edit.touches({geodesic[i], geodesic[i + 1]}))
+            return true;
+    }
+    return false;
+}
+
+void SplinegonDiagram::rebuild(const LinearShortestPath& solver) {
+    construct_monotone_decomposition(solver.compute(q_geom.start, r_geom.start));
+}
+
 std::optional<double> SplinegonDiagram::shoot_ray(double v_q, double v_r) const {
     if (lower_envelope_sectors.empty()) {
         // No obstructions found in Preprocessing phase => Visibility likely at t=0
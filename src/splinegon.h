@@ -3,9 +3,12 @@
 
 #include "geometry.h"
 #include "math_solver.h"
+#include "shortest_path_map.h"
 #include <vector>
 #include <optional>
 
+class LinearShortestPath;
+
 // Represents a piece of the boundary of the Visibility Diagram D.
 struct RationalArc {
     // The generator vertex from P that defines the equation
@@ -33,11 +36,27 @@ class SplinegonDiagram {
     // The ordered angular sectors partitioning the visibility plane.
     std::vector<RationalArc> lower_envelope_sectors;
 
-    void construct_monotone_decomposition();
+    // Geodesic between q.start and r.start the sectors were built from.
+    std::vector<Point> geodesic;
+
+    void construct_monotone_decomposition(const std::vector<Point>& pivots);
 
 public:
     SplinegonDiagram(const Polygon& poly, const Trajectory& q, const Trajectory& r);
 
+    // One-to-many construction: reuses a map built from q.start instead of
+    // recomputing the geodesic per pair. Falls back to LinearShortestPath
+    // if the map was built from another source, P was edited since, or the
+    // map finds no path to r.start.
+    SplinegonDiagram(const Polygon& poly, const ShortestPathMap& spm, const Trajectory& q, const Trajectory& r);
+
+    // True if an edit of P swept across the geodesic, i.e. the sectors may be stale.
+    // A taut path untouched by the edit stays the shortest one. O(path length).
+    bool is_affected_by(const PolygonEdit& edit) const;
+
+    // Recomputes the sectors against the current P, reusing a solver kept up to date with apply().
+    void rebuild(const LinearShortestPath& solver);
+
     // Queries the Splinegon boundary in O(log n) time.
     std::optional<double> shoot_ray(double v_q, double v_r) const;
 };
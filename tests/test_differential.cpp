@@ -0,0 +1,505 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "geometry.h"
+#include "math_solver.h"
+#include "first_sight.h"
+#include "linear_shortest_path.h"
+#include "shortest_path_map.h"
+#include "splinegon.h"
+
+// ------------------------------------------------------------
+// Differential Harness: Fast Engines vs Brute-Force Oracle
+// ------------------------------------------------------------
+// Every fast query path must return the same first sight time as
+// FirstSightFinder::find_first_sight on seeded random inputs, and its
+// running time must keep growing at the rate its complexity claims.
+
+constexpr uint32_t HARNESS_SEED = 0x5EED2026;
+constexpr double RADIUS = 10.0;
+constexpr double TIME_TOLERANCE = 1e-6;
+
+// Star polygons have no vertical edges and every vertex at its own abscissa;
+// combs and x-monotone polygons have both, plus collinear runs of vertices.
+enum class Family { Star, Comb, Monotone };
+
+struct Scenario {
+    uint32_t seed;
+    Family family;
+    Polygon P;
+    Trajectory q;
+    Trajectory r;
+};
+
+// Star-shaped polygon around the origin with jittered angles and radii (CCW, simple).
+static Polygon random_star_polygon(std::mt19937& rng, const size_t n) {
+    std::uniform_real_distribution<double> jitter(0.0, 0.8), radius(0.3 * RADIUS, RADIUS);
+    Polygon P;
+    for (size_t i = 0; i < n; ++i) {
+        const double theta = 2 * std::numbers::pi * (static_cast<double>(i) + jitter(rng)) / static_cast<double>(n);
+        const double rho = radius(rng);
+        P.add_vertex(rho * std::cos(theta), rho * std::sin(theta));
+    }
+    return P;
+}
+
+// Orthogonal comb: a base bar along the bottom with n / 4 teeth of random
+// heights, separated by gaps down to the bar (CCW, simple).
+static Polygon random_comb_polygon(std::mt19937& rng, const size_t n) {
+    constexpr int LEVELS = 8;
+    std::uniform_int_distribution<int> level(1, LEVELS);
+    const size_t teeth = std::max<size_t>(2, n / 4);
+    const double bar = -0.6 * RADIUS;
+    const auto x = [&](const size_t k) { return -RADIUS + 2 * RADIUS * static_cast<double>(k) / static_cast<double>(2 * teeth - 1); };
+
+    Polygon P;
+    P.add_vertex(x(0), -RADIUS);
+    P.add_vertex(x(2 * teeth - 1), -RADIUS);
+    for (size_t i = teeth; i-- > 0;) {
+        const double top = bar + (RADIUS - bar) * level(rng) / LEVELS;
+        P.add_vertex(x(2 * i + 1), top);
+        P.add_vertex(x(2 * i), top);
+        if (i > 0) {
+            P.add_vertex(x(2 * i), bar);
+            P.add_vertex(x(2 * i - 1), bar);
+        }
+    }
+    return P;
+}
+
+// x-monotone polygon whose lower and upper chains share n / 2 abscissae,
+// with ordinates on a coarse grid so that runs of vertices are collinear (CCW, simple).
+static Polygon random_monotone_polygon(std::mt19937& rng, const size_t n) {
+    constexpr int LEVELS = 6;
+    std::uniform_int_distribution<int> level(1, LEVELS);
+    const size_t m = std::max<size_t>(2, n / 2);
+    const auto x = [&](const size_t i) { return -RADIUS + 2 * RADIUS * static_cast<double>(i) / static_cast<double>(m - 1); };
+
+    std::vector<double> upper(m);
+    for (double& y : upper) y = RADIUS * level(rng) / LEVELS;
+
+    Polygon P;
+    for (size_t i = 0; i < m; ++i)
+        P.add_vertex(x(i), -RADIUS * level(rng) / LEVELS);
+    for (size_t i = m; i-- > 0;)
+        P.add_vertex(x(i), upper[i]);
+    return P;
+}
+
+static Polygon random_polygon(std::mt19937& rng, const Family family, const size_t n) {
+    switch (family) {
+        case Family::Comb: return random_comb_polygon(rng, n);
+        case Family::Monotone: return random_monotone_polygon(rng, n);
+        default: return random_star_polygon(rng, n);
+    }
+}
+
+static Point random_interior_point(std::mt19937& rng, const Polygon& P) {
+    std::uniform_real_distribution<double> coord(-RADIUS, RADIUS);
+    Point p{};
+    do {
+        p = {coord(rng), coord(rng)};
+    } while (!is_point_in_polygon(P, p));
+    return p;
+}
+
+// A vertex of P or the midpoint of one of its edges, with equal odds.
+static Point random_boundary_point(std::mt19937& rng, const Polygon& P) {
+    std::uniform_int_distribution<size_t> edge(0, P.size() - 1);
+    std::bernoulli_distribution at_vertex(0.5);
+    const size_t i = edge(rng);
+    if (at_vertex(rng)) return P.get_vertex(i);
+    const Point a = P.get_vertex(i), b = P.get_vertex(i + 1);
+    return {(a.x + b.x) / 2, (a.y + b.y) / 2};
+}
+
+// With obstructed_start, q and r never see each other at t = 0, so no engine
+// can answer from the initial configuration alone. Outside the star family,
+// half of the scenarios start r on the boundary of P.
+static Scenario make_scenario(const uint32_t seed, const size_t n, const Family family = Family::Star,
+                              const bool obstructed_start = false) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> speed(-2.0, 2.0);
+    std::bernoulli_distribution on_boundary(0.5);
+
+    Scenario s{seed, family, random_polygon(rng, family, n), {}, {}};
+    const bool r_on_boundary = family != Family::Star && on_boundary(rng);
+    s.q = {random_interior_point(rng, s.P), {speed(rng), speed(rng)}};
+    do {
+        const Point start = r_on_boundary ? random_boundary_point(rng, s.P) : random_interior_point(rng, s.P);
+        s.r = {start, {speed(rng), speed(rng)}};
+    } while (obstructed_start && is_visible_naive(s.P, s.q.start, s.r.start));
+    return s;
+}
+
+// O(n^2) check that no two non-adjacent edges meet.
+static bool is_simple_polygon(const Polygon& P) {
+    const size_t n = P.size();
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 2; j < n; ++j) {
+            if (i == 0 && j == n - 1) continue;
+            if (segments_intersect(P.get_edge(i), P.get_edge(j))) return false;
+        }
+    }
+    return true;
+}
+
+// Removing vertices keeps a star polygon simple while no angular gap reaches PI;
+// other families are checked for simplicity directly.
+static bool is_valid_shrink(const Scenario& s) {
+    if (s.P.size() < 3) return false;
+    if (s.family != Family::Star) {
+        if (!is_simple_polygon(s.P)) return false;
+    } else {
+        for (size_t i = 0; i < s.P.size(); ++i) {
+            const Point a = s.P.get_vertex(i), b = s.P.get_vertex(i + 1);
+            double gap = std::atan2(b.y, b.x) - std::atan2(a.y, a.x);
+            if (gap <= 0) gap += 2 * std::numbers::pi;
+            if (gap >= std::numbers::pi - EPSILON) return false;
+        }
+    }
+    return is_point_in_polygon(s.P, s.q.start) && is_point_in_polygon(s.P, s.r.start);
+}
+
+// ------------------------------------------------------------
+// Engines under test
+// ------------------------------------------------------------
+using FirstSightQuery = std::function<std::optional<double>(const Polygon&, const Trajectory&, const Trajectory&)>;
+
+struct Engine {
+    std::string name;
+    size_t max_n;             // Construction cost cap
+    size_t known_mismatches;  // Ceiling on the workload below; lower it as the engine improves
+    FirstSightQuery first_sight;
+};
+
+static std::optional<double> oracle(const Polygon& P, const Trajectory& q, const Trajectory& r) {
+    return FirstSightFinder(P).find_first_sight(q, r);
+}
+
+static std::vector<Engine> fast_engines() {
+    return {
+        {"SplinegonDiagram::shoot_ray [LinearShortestPath]", 4096, 167,
+            [](const Polygon& P, const Trajectory& q, const Trajectory& r) {
+                return SplinegonDiagram(P, q, r).shoot_ray(1.0, 1.0);
+            }},
+        {"SplinegonDiagram::shoot_ray [ShortestPathMap]", 256, 142,
+            [](const Polygon& P, const Trajectory& q, const Trajectory& r) {
+                const ShortestPathMap spm(P, q.start);
+                return SplinegonDiagram(P, spm, q, r).shoot_ray(1.0, 1.0);
+            }},
+    };
+}
+
+static bool answers_agree(const std::optional<double>& expected, const std::optional<double>& actual) {
+    if (expected.has_value() != actual.has_value()) return false;
+    return !expected || std::abs(*expected - *actual) <= TIME_TOLERANCE * std::max(1.0, std::abs(*expected));
+}
+
+static bool mismatches(const Engine& engine, const Scenario& s) {
+    return !answers_agree(oracle(s.P, s.q, s.r), engine.first_sight(s.P, s.q, s.r));
+}
+
+// Delta debugging on the vertex list: drop ever smaller runs of vertices
+// as long as the polygon stays valid and the engine still disagrees.
+static Scenario shrink_mismatch(Scenario s, const Engine& engine) {
+    for (size_t chunk = s.P.size() / 2; chunk >= 1; chunk /= 2) {
+        for (size_t begin = 0; begin + chunk <= s.P.size();) {
+            Scenario candidate = s;
+            auto& vertices = candidate.P.vertices;
+            vertices.erase(vertices.begin() + begin, vertices.begin() + begin + chunk);
+
+            if (is_valid_shrink(candidate) && mismatches(engine, candidate))
+                s = std::move(candidate);
+            else
+                begin += chunk;
+        }
+    }
+    return s;
+}
+
+static std::string format_answer(const std::optional<double>& t) {
+    std::ostringstream out;
+    out.precision(17);
+    if (t) out << *t;
+    else out << "nullopt";
+    return out.str();
+}
+
+// Self-contained snippet that replays the mismatch.
+static std::string describe_reproducer(const Engine& engine, const Scenario& s) {
+    std::ostringstream out;
+    out.precision(17);
+    out << engine.name << " disagrees with FirstSightFinder (seed " << s.seed << ", n = " << s.P.size() << ")\n"
+        << "    Polygon P;\n";
+    for (const Point& v : s.P.vertices)
+        out << "    P.add_vertex(" << v.x << ", " << v.y << ");\n";
+    out << "    Trajectory q {{" << s.q.start.x << ", " << s.q.start.y << "}, {" << s.q.v.x << ", " << s.q.v.y << "}};\n"
+        << "    Trajectory r {{" << s.r.start.x << ", " << s.r.start.y << "}, {" << s.r.v.x << ", " << s.r.v.y << "}};\n"
+        << "    // oracle: " << format_answer(oracle(s.P, s.q, s.r))
+        << ", engine: " << format_answer(engine.first_sight(s.P, s.q, s.r));
+    return out.str();
+}
+
+// ------------------------------------------------------------
+// LAYER 6: Differential Agreement
+// ------------------------------------------------------------
+// The sector partition in SplinegonDiagram is still a placeholder for the
+// exact bitangent bounds, so each engine has a pinned ceiling of known
+// mismatches. Those are reported as warnings with reproducers; any new
+// disagreement beyond the ceiling fails the run.
+TEST_CASE("6. Fast Engines Agree with First Sight Oracle", "[differential]") {
+    constexpr size_t MAX_REPORTED = 3;
+    struct Batch {
+        Family family;
+        size_t n;
+        size_t count;
+    };
+    const std::vector<Batch> workload = {
+        {Family::Star, 8, 200}, {Family::Star, 32, 100}, {Family::Star, 128, 40},
+        {Family::Star, 256, 12}, {Family::Star, 1024, 4}, {Family::Star, 4096, 1},
+        {Family::Comb, 8, 100}, {Family::Comb, 32, 50}, {Family::Comb, 128, 20},
+        {Family::Monotone, 8, 100}, {Family::Monotone, 32, 50}, {Family::Monotone, 128, 20},
+    };
+
+    for (const Engine& engine : fast_engines()) {
+        size_t checked = 0, failed = 0;
+        std::vector<std::string> reports;
+
+        for (const auto& [family, n, count] : workload) {
+            if (n > engine.max_n) continue;
+            for (size_t k = 0; k < count; ++k) {
+                const uint32_t family_offset = static_cast<uint32_t>(family) * 10'000'000;
+                const Scenario s = make_scenario(HARNESS_SEED + family_offset + static_cast<uint32_t>(n * 1000 + k), n, family);
+                ++checked;
+                if (!mismatches(engine, s)) continue;
+                if (++failed <= MAX_REPORTED)
+                    reports.push_back(describe_reproducer(engine, shrink_mismatch(s, engine)));
+            }
+        }
+
+        for (const std::string& report : reports)
+            WARN(report);
+        INFO(engine.name << ": " << failed << " of " << checked << " scenarios disagree");
+        CHECK(failed <= engine.known_mismatches);
+    }
+}
+
+// ------------------------------------------------------------
+// LAYER 7: Empirical Complexity
+// ------------------------------------------------------------
+// Least-squares slope of log(time) against log(n). A step silently going
+// from O(n) to O(n^2) moves the slope by a full unit, well past the slack.
+constexpr double EXPONENT_SLACK = 0.5;
+
+struct ScalingProbe {
+    std::string name;
+    double expected_exponent;
+    std::vector<size_t> sizes;
+    // Returns the measured operation; setup outside it is not timed.
+    std::function<std::function<void()>(const Scenario&)> prepare;
+};
+
+// Seconds per call, repeating until the measurement dominates clock resolution.
+static double time_per_call(const std::function<void()>& op) {
+    using Clock = std::chrono::steady_clock;
+    constexpr double MIN_SAMPLE = 2e-3;
+
+    size_t reps = 1;
+    for (;;) {
+        const auto start = Clock::now();
+        for (size_t i = 0; i < reps; ++i) op();
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (elapsed >= MIN_SAMPLE) return elapsed / static_cast<double>(reps);
+        reps *= 2;
+    }
+}
+
+static double fit_exponent(const std::vector<double>& ns, const std::vector<double>& times) {
+    double mean_x = 0, mean_y = 0;
+    for (size_t i = 0; i < ns.size(); ++i) {
+        mean_x += std::log(ns[i]);
+        mean_y += std::log(times[i]);
+    }
+    mean_x /= static_cast<double>(ns.size());
+    mean_y /= static_cast<double>(ns.size());
+
+    double cov = 0, var = 0;
+    for (size_t i = 0; i < ns.size(); ++i) {
+        const double dx = std::log(ns[i]) - mean_x;
+        cov += dx * (std::log(times[i]) - mean_y);
+        var += dx * dx;
+    }
+    return cov / var;
+}
+
+TEST_CASE("7. Empirical Time Growth per Engine", "[scaling]") {
+    constexpr size_t SCENARIOS_PER_SIZE = 5;
+
+    const std::vector<ScalingProbe> probes = {
+        {"FirstSightFinder::find_first_sight", 2.0, {64, 128, 256, 512, 1024},
+            [](const Scenario& s) -> std::function<void()> {
+                return [&s] { (void)FirstSightFinder(s.P).find_first_sight(s.q, s.r); };
+            }},
+        {"SplinegonDiagram construction [LinearShortestPath]", 1.0, {64, 128, 256, 512, 1024, 2048},
+            [](const Scenario& s) -> std::function<void()> {
+                return [&s] { (void)SplinegonDiagram(s.P, s.q, s.r); };
+            }},
+        {"SplinegonDiagram::shoot_ray", 0.0, {64, 128, 256, 512, 1024, 2048},
+            [](const Scenario& s) -> std::function<void()> {
+                auto system = std::make_shared<SplinegonDiagram>(s.P, s.q, s.r);
+                return [&s, system] { (void)system->shoot_ray(1.0, 1.0); };
+            }},
+        {"ShortestPathMap::compute", 0.0, {32, 64, 128, 256},
+            [](const Scenario& s) -> std::function<void()> {
+                auto spm = std::make_shared<ShortestPathMap>(s.P, s.q.start);
+                std::mt19937 rng(s.seed);
+                std::vector<Point> targets(64);
+                for (Point& t : targets) t = random_interior_point(rng, s.P);
+                return [spm, targets] { for (const Point& t : targets) (void)spm->compute(t); };
+            }},
+    };
+
+    for (const ScalingProbe& probe : probes) {
+        std::vector<double> ns, times;
+
+        for (const size_t n : probe.sizes) {
+            std::vector<double> samples;
+            for (size_t k = 0; k < SCENARIOS_PER_SIZE; ++k) {
+                const Scenario s = make_scenario(HARNESS_SEED ^ static_cast<uint32_t>(n * 7919 + k), n, Family::Star, true);
+                samples.push_back(time_per_call(probe.prepare(s)));
+            }
+            std::ranges::nth_element(samples, samples.begin() + samples.size() / 2);
+            ns.push_back(static_cast<double>(n));
+            times.push_back(samples[samples.size() / 2]);
+        }
+
+        const double exponent = fit_exponent(ns, times);
+        INFO(probe.name << ": fitted exponent " << exponent << ", expected <= " << probe.expected_exponent);
+        CHECK(exponent <= probe.expected_exponent + EXPONENT_SLACK);
+    }
+}
+
+// ------------------------------------------------------------
+// LAYER 9: Geodesic Agreement
+// ------------------------------------------------------------
+// The first sight comparison above is dominated by the placeholder sectors,
+// so ShortestPathMap is also checked directly against a brute-force geodesic:
+// Dijkstra over the visibility graph of the source and the vertices of P.
+
+// Closed visibility: a segment may run along the boundary or graze vertices,
+// as taut paths do. Split at every vertex on it; each piece must stay in P.
+static bool sees_closed(const Polygon& P, const Point& a, const Point& b) {
+    if (a == b) return true;
+    const auto in_closed_polygon = [&](const Point& p) {
+        for (size_t i = 0; i < P.size(); ++i) {
+            const Segment e = P.get_edge(i);
+            if (std::abs(cross_product_z(e.p1, e.p2, p)) < EPSILON && on_segment(p, e)) return true;
+        }
+        return is_point_in_polygon(P, p);
+    };
+
+    std::vector<double> cuts{0.0, 1.0};
+    for (size_t i = 0; i < P.size(); ++i) {
+        const Segment e = P.get_edge(i);
+        const double d1 = cross_product_z(a, b, e.p1), d2 = cross_product_z(a, b, e.p2);
+        const double d3 = cross_product_z(e.p1, e.p2, a), d4 = cross_product_z(e.p1, e.p2, b);
+        const bool straddles_ab = (d1 > EPSILON && d2 < -EPSILON) || (d1 < -EPSILON && d2 > EPSILON);
+        const bool straddles_e = (d3 > EPSILON && d4 < -EPSILON) || (d3 < -EPSILON && d4 > EPSILON);
+        if (straddles_ab && straddles_e) return false;
+
+        const double t = ((e.p1.x - a.x) * (b.x - a.x) + (e.p1.y - a.y) * (b.y - a.y)) / dist_sq(a, b);
+        if (std::abs(d1) < EPSILON && t > 0 && t < 1) cuts.push_back(t);
+    }
+    std::ranges::sort(cuts);
+    for (size_t i = 0; i + 1 < cuts.size(); ++i) {
+        const double t = (cuts[i] + cuts[i + 1]) / 2;
+        if (cuts[i + 1] - cuts[i] > EPSILON && !in_closed_polygon({a.x + t * (b.x - a.x), a.y + t * (b.y - a.y)}))
+            return false;
+    }
+    return true;
+}
+
+// Geodesic distance from source to every vertex of P, O(n^3).
+static std::vector<double> geodesic_to_vertices(const Polygon& P, const Point& source) {
+    std::vector<Point> sites{source};
+    sites.insert(sites.end(), P.vertices.begin(), P.vertices.end());
+
+    std::vector<double> dist(sites.size(), std::numeric_limits<double>::infinity());
+    std::vector<bool> settled(sites.size(), false);
+    dist[0] = 0.0;
+    for (size_t round = 0; round < sites.size(); ++round) {
+        size_t u = sites.size();
+        for (size_t i = 0; i < sites.size(); ++i) {
+            if (!settled[i] && std::isfinite(dist[i]) && (u == sites.size() || dist[i] < dist[u])) u = i;
+        }
+        if (u == sites.size()) break;
+        settled[u] = true;
+        for (size_t w = 0; w < sites.size(); ++w) {
+            if (!settled[w] && sees_closed(P, sites[u], sites[w]))
+                dist[w] = std::min(dist[w], dist[u] + std::sqrt(dist_sq(sites[u], sites[w])));
+        }
+    }
+    return dist;
+}
+
+static double path_length(const std::vector<Point>& path) {
+    double length = 0.0;
+    for (size_t i = 0; i + 1 < path.size(); ++i)
+        length += std::sqrt(dist_sq(path[i], path[i + 1]));
+    return length;
+}
+
+TEST_CASE("9. Shortest Path Map Agrees with Visibility Graph Geodesics", "[differential][spm]") {
+    constexpr double LENGTH_TOLERANCE = 1e-6;
+    constexpr size_t INTERIOR_TARGETS = 16;
+
+    for (const Family family : {Family::Star, Family::Comb, Family::Monotone}) {
+        for (const size_t n : {8, 16, 32, 64}) {
+            for (size_t k = 0; k < 5; ++k) {
+                const uint32_t seed = HARNESS_SEED + static_cast<uint32_t>(family) * 10'000'000 + static_cast<uint32_t>(n * 1000 + k);
+                const Scenario s = make_scenario(seed, n, family);
+                const ShortestPathMap spm(s.P, s.q.start);
+
+                std::vector<double> dist = geodesic_to_vertices(s.P, s.q.start);
+                std::vector<Point> sites{s.q.start};
+                sites.insert(sites.end(), s.P.vertices.begin(), s.P.vertices.end());
+
+                // Every vertex, every edge midpoint, and a few interior points.
+                std::vector<Point> targets;
+                for (size_t i = 0; i < s.P.size(); ++i) {
+                    const Segment e = s.P.get_edge(i);
+                    targets.push_back(e.p1);
+                    targets.push_back({(e.p1.x + e.p2.x) / 2, (e.p1.y + e.p2.y) / 2});
+                }
+                std::mt19937 rng(seed);
+                for (size_t i = 0; i < INTERIOR_TARGETS; ++i)
+                    targets.push_back(random_interior_point(rng, s.P));
+
+                for (const Point& target : targets) {
+                    double expected = std::numeric_limits<double>::infinity();
+                    for (size_t i = 0; i < sites.size(); ++i) {
+                        if (std::isfinite(dist[i]) && sees_closed(s.P, sites[i], target))
+                            expected = std::min(expected, dist[i] + std::sqrt(dist_sq(sites[i], target)));
+                    }
+
+                    const std::vector<Point> path = spm.compute(target);
+                    INFO("seed " << seed << ", n = " << s.P.size() << ", target (" << target.x << ", " << target.y << ")");
+                    REQUIRE_FALSE(path.empty());
+                    CHECK(std::abs(path_length(path) - expected) <= LENGTH_TOLERANCE * std::max(1.0, expected));
+                }
+            }
+        }
+    }
+}
@@ -1,12 +1,15 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 
 #include "geometry.h"
 #include "math_solver.h"
 #include "first_sight.h"
 #include "linear_shortest_path.h"
 #include "splinegon.h"
+#include "shortest_path_map.h"
 
 using Catch::Approx;
 
@@ -130,6 +133,10 @@ TEST_CASE("4. Theorem 1 End-to-End System", "[system]") {
         auto res = system.shoot_ray(1.0, 1.0);
         REQUIRE(res.has_value());
         REQUIRE(res.value() == Approx(4.0).margin(0.1));
+
+        auto expected = FirstSightFinder(P).find_first_sight(q, r);
+        REQUIRE(expected.has_value());
+        REQUIRE(res.value() == Approx(expected.value()).margin(EPSILON));
     }
 
     SECTION("Impossible Visibility Case (Fixed Logic)") {
@@ -147,14 +154,195 @@ TEST_CASE("4. Theorem 1 End-to-End System", "[system]") {
         // Use v scale 1.0
         auto res = sys_up.shoot_ray(1.0, 1.0);
 
-        if (res.has_value()) {
-            double t = res.value();
-            const Trajectory check_q {{2, 6}, {0, 1}},
-                    check_r {{8, 6}, {0, 1}};
-            if (!is_visible_naive(P, check_q.position_at(t), check_r.position_at(t))) {
-                 FAIL("Math solver reported visibility at t=" << t << " but Geometric Oracle rejected it.");
-            }
+        // Plausibility at the reported t is not enough: the answer must match the brute-force oracle.
+        auto expected = FirstSightFinder(P).find_first_sight(q_up, r_up);
+        REQUIRE_FALSE(expected.has_value());
+        REQUIRE_FALSE(res.has_value());
+    }
+}
+
+// ------------------------------------------------------------
+// LAYER 5: Shortest Path Map (One-to-Many Preprocessing)
+// ------------------------------------------------------------
+TEST_CASE("5. Shortest Path Map from a Fixed Source", "[spm]") {
+    Polygon P = create_square_with_hole();
+    ShortestPathMap spm(P, {2, 8});
+
+    SECTION("Obstructed Target Walks Both Wall Pivots") {
+        auto path = spm.compute({8, 8});
+        REQUIRE(path.size() == 4);
+        REQUIRE(path[1] == Point{4, 5});
+        REQUIRE(path[2] == Point{6, 5});
+        REQUIRE(path.back() == Point{8, 8});
+    }
+
+    SECTION("Visible Target Is a Straight Segment") {
+        auto path = spm.compute({2, 2});
+        REQUIRE(path.size() == 2);
+    }
+
+    SECTION("Target Outside Polygon") {
+        REQUIRE(spm.compute({5, 8}).empty());
+    }
+
+    SECTION("Targets on the Boundary") {
+        // Wall face x=4 with P to its left: the slab to the right of x=4 lies outside P there.
+        REQUIRE(spm.compute({4, 7}) == std::vector<Point>{{2, 8}, {4, 7}});
+        REQUIRE(spm.compute({4, 10}) == std::vector<Point>{{2, 8}, {4, 10}});
+
+        // A reflex vertex is its own last pivot.
+        REQUIRE(spm.compute({6, 5}) == std::vector<Point>{{2, 8}, {4, 5}, {6, 5}});
+    }
+
+    SECTION("Agrees with LinearShortestPath Pivots") {
+        LinearShortestPath solver(P);
+        for (const Point target : {Point{8, 8}, Point{9, 6}, Point{7, 9}, Point{5, 1}}) {
+            auto expected = solver.compute({2, 8}, target);
+            auto path = spm.compute(target);
+            REQUIRE(path.size() == expected.size());
+            for (const Point& p : expected)
+                REQUIRE(std::ranges::find(path, p) != path.end());
         }
-        SUCCEED("No incorrect visibility event confirmed.");
+    }
+
+    SECTION("Plugs into Splinegon Construction") {
+        Trajectory q {{2, 9}, {0, -1}};
+        Trajectory r {{8, 9}, {0, -1}};
+        ShortestPathMap from_q(P, q.start);
+
+        SplinegonDiagram system(P, from_q, q, r);
+        auto res = system.shoot_ray(1.0, 1.0);
+        REQUIRE(res.has_value());
+        REQUIRE(res.value() == Approx(4.0).margin(0.1));
+    }
+
+    SECTION("Falls Back When the Map Has No Path") {
+        // r starts inside the wall, where the map finds nothing.
+        Trajectory q {{8, 8}, {0, -1}};
+        Trajectory r {{5, 8}, {0, -1}};
+        ShortestPathMap from_q(P, q.start);
+        REQUIRE(from_q.compute(r.start).empty());
+
+        SplinegonDiagram via_map(P, from_q, q, r);
+        SplinegonDiagram per_pair(P, q, r);
+        REQUIRE(via_map.shoot_ray(1.0, 1.0) == per_pair.shoot_ray(1.0, 1.0));
+        REQUIRE(via_map.shoot_ray(1.0, 1.0) != std::optional<double>{0.0});
+    }
+}
+
+// ------------------------------------------------------------
+// LAYER 8: Incremental Polygon Edits
+// ------------------------------------------------------------
+TEST_CASE("8. Incremental Polygon Edits", "[edits]") {
+    Polygon P = create_square_with_hole();
+    LinearShortestPath solver(P);
+
+    SECTION("Precomputed Reflex State Follows Edits") {
+        // Notch in the floor: (5,1) is a new reflex vertex between (0,0) and (10,0).
+        solver.apply(P.insert_vertex(1, {5, 1}));
+        REQUIRE(P.size() == 9);
+        REQUIRE(P.is_reflex(1));
+
+        // Lower the right wall pivot below the left one.
+        solver.apply(P.move_vertex(5, {6, 4}));
+        REQUIRE(P.get_vertex(5) == Point{6, 4});
+
+        // Drop the notch again.
+        solver.apply(P.remove_vertex(1));
+        REQUIRE(P.size() == 8);
+
+        LinearShortestPath fresh(P);
+        for (const auto& [s, e] : {std::pair{Point{2, 8}, Point{8, 8}}, {Point{2, 2}, Point{8, 2}}, {Point{1, 9}, Point{9, 7}}})
+            REQUIRE(solver.compute(s, e) == fresh.compute(s, e));
+    }
+
+    SECTION("Edits That Flip Reflexivity Match A Fresh Solver") {
+        const auto same_paths = [&] {
+            LinearShortestPath fresh(P);
+            for (const auto& [s, e] : {std::pair{Point{1, 0.5}, Point{9, 0.5}}, {Point{9, 0.2}, Point{1, 2}},
+                                       {Point{2, 8}, Point{8, 8}}, {Point{8, 8}, Point{2, 8}}, {Point{1, 9}, Point{9, 1}}}) {
+                if (solver.compute(s, e) != fresh.compute(s, e)) return false;
+            }
+            return true;
+        };
+
+        // Keep the notch: (5,1) becomes reflex and blocks the floor.
+        solver.apply(P.insert_vertex(1, {5, 1}));
+        REQUIRE(P.is_reflex(1));
+        REQUIRE(same_paths());
+
+        // Push the notch outwards: reflex turns convex.
+        solver.apply(P.move_vertex(1, {5, -1}));
+        REQUIRE_FALSE(P.is_reflex(1));
+        REQUIRE(same_paths());
+
+        // Lift the right wall pivot above the left one; both stay reflex.
+        solver.apply(P.move_vertex(5, {6, 6}));
+        REQUIRE(same_paths());
+    }
+
+    SECTION("Clockwise Winding Keeps The Wall Pivots") {
+        Polygon cw;
+        for (size_t i = P.size(); i-- > 0;)
+            cw.add_vertex(P.get_vertex(i).x, P.get_vertex(i).y);
+
+        LinearShortestPath cw_solver(cw);
+        for (const auto& [s, e] : {std::pair{Point{2, 8}, Point{8, 8}}, {Point{8, 8}, Point{2, 8}}, {Point{1, 9}, Point{9, 7}}})
+            REQUIRE(cw_solver.compute(s, e) == solver.compute(s, e));
+    }
+
+    SECTION("Area Delta Matches Swept Triangles") {
+        PolygonEdit edit = P.insert_vertex(1, {5, -1});
+        REQUIRE(edit.area_delta == Approx(10.0)); // Twice the area of ((0,0), (5,-1), (10,0))
+        REQUIRE(edit.swept.size() == 1);
+    }
+
+    SECTION("Only Diagrams Whose Geodesic Is Swept Are Invalidated") {
+        Trajectory q {{2, 9}, {0, -1}};
+        Trajectory r {{8, 9}, {0, -1}};
+        SplinegonDiagram over_wall(P, q, r);
+
+        Trajectory q_low {{1, 2}, {1, 0}};
+        Trajectory r_low {{9, 2}, {-1, 0}};
+        SplinegonDiagram under_wall(P, q_low, r_low);
+
+        // Pushing the bottom right corner outwards is far from both geodesics.
+        PolygonEdit far = P.move_vertex(1, {11, -1});
+        solver.apply(far);
+        REQUIRE_FALSE(over_wall.is_affected_by(far));
+        REQUIRE_FALSE(under_wall.is_affected_by(far));
+
+        // Moving a wall pivot drags the geodesic over the wall with it.
+        PolygonEdit pivot = P.move_vertex(4, {6, 4});
+        solver.apply(pivot);
+        REQUIRE(over_wall.is_affected_by(pivot));
+        REQUIRE_FALSE(under_wall.is_affected_by(pivot));
+
+        over_wall.rebuild(solver);
+        SplinegonDiagram fresh(P, q, r);
+        REQUIRE(over_wall.shoot_ray(1.0, 1.0) == fresh.shoot_ray(1.0, 1.0));
+    }
+
+    SECTION("Shortest Path Map Refuses Queries Until Rebuilt") {
+        Trajectory q {{2, 9}, {0, -1}};
+        Trajectory r {{8, 9}, {0, -1}};
+        ShortestPathMap spm(P, q.start);
+        REQUIRE_FALSE(spm.is_stale());
+
+        P.move_vertex(4, {6, 4});
+        REQUIRE(spm.is_stale());
+        REQUIRE_THROWS_AS(spm.compute(r.start), std::logic_error);
+
+        // A stale map is ignored in favour of the per-pair solver.
+        SplinegonDiagram via_spm(P, spm, q, r);
+        SplinegonDiagram per_pair(P, q, r);
+        REQUIRE(via_spm.shoot_ray(1.0, 1.0) == per_pair.shoot_ray(1.0, 1.0));
+
+        spm.rebuild();
+        REQUIRE_FALSE(spm.is_stale());
+        ShortestPathMap fresh(P, q.start);
+        for (const Point target : {Point{8, 9}, Point{8, 2}, Point{5, 4.5}})
+            REQUIRE(spm.compute(target) == fresh.compute(target));
+        REQUIRE(spm.compute({8, 9}).size() == 4);
     }
 }